@@ -12,7 +12,7 @@ rm input_rdict.pcm 2>/dev/null
 
 echo Compiling the program
 rootcint input.cxx -c input.h
-g++ `root-config --cflags --glibs` -O3 -lCore -lRIO -lNet -lHist -lGraf -lGui -lSpectrum -DNOROOT=1 -Wunused-variable -Wall -Wextra input.cxx DetectorEfficiency.C -o EfficiencyCalibrator
+g++ `root-config --cflags --glibs` -O3 -pthread -lCore -lRIO -lNet -lTree -lHist -lGraf -lGui -lSpectrum -lMathCore -lMinuit2 -DNOROOT=1 -Wunused-variable -Wall -Wextra input.cxx DetectorEfficiency.C BatchCalibration.C PeakMatcher.C PeakFitter.C FitModels.C SpectrumIngest.C OnlineCalibration.C EfficiencyBootstrap.C Benchmark.C Telemetry.C -o EfficiencyCalibrator
 
 
 echo The program is ready to use
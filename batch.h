@@ -0,0 +1,142 @@
+////////////////////////////////////////////////
+//Author: Sophia Devinyak (s.devinyak@gmail.com , sdevinya@uwaterloo.ca)
+//Headless (no GUI) calibration engine used by the --batch and --array modes of the EfficiencyCalibrator
+
+
+
+#ifndef __batch_h__
+#define __batch_h__
+
+#include "bootstrap.h"
+#include "spectrum.h"
+#include "telemetry.h"
+#include <TH1F.h>
+#include <TDatime.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+// calibration sources from the literature, defined at the beginning of DetectorEfficiency.C
+extern std::vector<std::string> allIsotopes;
+extern std::vector<double> allHalfLives;
+extern std::vector<double> dallHalfLives;
+extern std::vector<float> limits;
+extern std::vector<std::vector <float>> allEnergy;
+extern std::vector<std::vector <float>> alldEnergy;
+extern std::vector<std::vector <float>> allYield;
+extern std::vector<std::vector <float>> alldYield;
+
+// fitting functions, defined at the end of DetectorEfficiency.C
+Double_t calibration(Double_t *x, Double_t *par);
+Double_t gausbkg(Double_t *x, Double_t *par);
+Double_t bkg(Double_t *x, Double_t *par);
+Double_t effFunc(Double_t *x, Double_t *par);
+
+////////////////////////////////////////////////////////////////////////////////
+/// All the information about one calibration run. These are the same fields as in the Detector Efficiency - File Input window.
+struct calibConfig
+{
+        std::string file;				///< Path to the .root file with the gamma spectrum histogram.
+        std::string canvas;				///< Name of the canvas in that .root file that contains the histogram, - if the histogram is saved directly in the file, tree or events for list-mode data.
+        std::string histogram;				///< Name of the histogram, tree:branch for list-mode data in a TTree, or the record format of a binary event file.
+        std::string isotope;				///< Name of the calibration source, must be one of allIsotopes, or "auto" to identify it from the found peaks.
+        double refActivity = 0;				///< Reference activity of the source in Bq.
+        double dRefActivity = 0;			///< Uncertainty in the reference activity of the source in Bq.
+        TDatime refDate;				///< Date when the reference activity of the source was measured.
+        TDatime runDate;				///< Date of the calibration run.
+        double runLength = 0;				///< Length of the calibration run in seconds.
+        double dRunLength = 0;				///< Uncertainty of the calibration run length in seconds. 0 means the default of 1 s.
+        double sensitivity = 0.0005;			///< Sensitivity of the peak search (smallest peak height / tallest peak height).
+        unsigned int fitThreads = 1;			///< Number of threads used to fit the peaks (and the replicas of the efficiency fit) of this run.
+        unsigned int replicas = 0;			///< Number of replicas for the uncertainty of the efficiency curve (see bootstrapEfficiency), 0 for none.
+        ingestConfig ingest;				///< Binning, gate and threads used to fill the spectrum from list-mode data.
+        std::string output;				///< Path of the file the calibration is written to.
+        std::string telemetry;				///< Log file the time of every stage and the result of every fit are appended to (see telemetry::write), empty for none.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Result of the fit of one gamma peak that was correlated with a peak from the literature.
+struct peakResult
+{
+        double channel = 0;				///< Centroid of the gaussian fit in detector channels.
+        double dChannel = 0;				///< Uncertainty of the centroid.
+        double energy = 0;				///< Centroid of the gaussian fit in keV.
+        double litEnergy = 0;				///< Energy of the matching peak from the literature in keV. 0 if no literature peak is within 2.3 keV.
+        double area = 0;				///< Area of the gaussian fit (# of gamma particles detected in the peak).
+        double dArea = 0;				///< Uncertainty of the area.
+        double sigma = 0;				///< Standard deviation of the gaussian fit in detector channels.
+        double chi2 = 0;				///< Chi2 of the peak fit.
+        int ndf = 0;					///< Number of degrees of freedom of the peak fit.
+        bool used = false;				///< True if the peak was used in the efficiency fit (replaces the Yes/No buttons of the GUI).
+        double eff = 0;					///< Efficiency of the detector at this peak.
+        double dEff = 0;				///< Uncertainty of the efficiency.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Everything the batch calibration of one run produces.
+struct calibResult
+{
+        bool ok = false;				///< True if all the stages succeeded.
+        std::string message;				///< Description of the failure if ok is false.
+        int iso = -1;					///< Index of the isotope in allIsotopes.
+        std::vector<std::string> isotopes;		///< All the isotopes identified in the spectrum (more than one for a mixture of sources).
+        double activity = 0;				///< Activity of the source at the time of the calibration run in Bq.
+        double dact = 0;				///< Uncertainty of the activity.
+        int nFound = 0;					///< Number of peaks found by the gamma peak search.
+        double m = 0;					///< Slope of the channel->energy calibration (E = m*ch + b).
+        double b = 0;					///< Offset of the channel->energy calibration.
+        double dm = 0;					///< Uncertainty of the slope.
+        double db = 0;					///< Uncertainty of the offset.
+        double mbCov = 0;				///< Covariance of the slope and the offset.
+        std::vector<peakResult> peaks;			///< All the fitted peaks.
+        std::vector<double> effPar;			///< Parameters of the effFunc fit.
+        std::vector<double> dEffPar;			///< Uncertainties of the effFunc parameters.
+        double effChi2 = 0;				///< Chi2 of the efficiency fit.
+        int effNdf = 0;					///< Number of degrees of freedom of the efficiency fit.
+        efficiencyBand band;				///< Covariance of the efficiency parameters and confidence band from the replicas (if cfg.replicas>0).
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Runs the whole calibration of one run (search, correlation, peak fits, efficiency fit) without any window.
+/// Every object owns all of its state, so several calibrations can run at the same time on different threads.
+class batchCalibration
+{
+        private:
+        calibConfig cfg;				///< The information about the run.
+        calibResult res;				///< The calibration of the run.
+        spectrumPtr spectrum;				///< The gamma spectrum, shared by all the stages.
+        std::vector<float> gMean;			///< Centroids of the found peaks.
+        std::vector<float> gHeight;			///< Heights of the found peaks.
+        std::vector<float> found;			///< Found peaks that were identified as peaks from the literature.
+        std::vector<float> lit;				///< Peaks from the literature that the found peaks matched with.
+        std::vector<float> height;			///< Heights of the identified peaks.
+        int candidates = 0;				///< Number of candidate mappings scored by the correlation.
+        telemetry log;					///< Time of every stage and result of every fit of this calibration.
+        bool fail(const std::string &message);		///< Records the reason of the failure and returns false.
+        public:
+        batchCalibration(const calibConfig &config);	///< Class constructor: stores the run information.
+        void setSpectrum(spectrumPtr counts);		///< Uses this spectrum instead of reading it from the file.
+        bool loadSpectrum();				///< Reads the spectrum from the .root file or from the list-mode data.
+        bool computeActivity();				///< Calculates the activity of the source at the time of the calibration run.
+        bool searchPeaks();				///< Searches for gamma peaks.
+        bool correlatePeaks();				///< Correlates the found peaks with the peaks from the literature and fits the channel->energy calibration.
+        bool fitPeaks();				///< Fits gaussians to all the correlated peaks.
+        bool fitEfficiency();				///< Calculates the efficiency at every peak and fits the efficiency curve.
+        bool estimateUncertainty();			///< Covariance and confidence band of the efficiency curve from resampled replicas of the points.
+        bool run();					///< Runs all the stages in order. Returns false if any of them failed.
+        bool write(const std::string &path) const;	///< Writes the calibration to a JSON file.
+        const calibResult &result() const {return res;}	///< The calibration of the run.
+        const telemetry &telemetryLog() const {return log;}	///< Time of every stage and result of every fit.
+};
+
+bool sourceActivity(int iso, double refActivity, double dRefActivity, const TDatime &reference, const TDatime &measurement, double &act, double &dact);	///< Activity of the source at the time of the calibration run and its uncertainty
+int findIsotope(const std::string &name);								///< Index of the isotope in allIsotopes, -1 if it is not there
+bool linearCalibration(const std::vector<double> &channels, const std::vector<double> &energies, const std::vector<double> &weights, double &m, double &b, double &dm, double &db, double *mbCov = nullptr);	///< Weighted least squares fit of E = m*ch + b
+int efficiencyPoints(int iso, double activity, double dact, double runLength, double dRunLength, std::vector<peakResult> &peaks,
+                     std::vector<double> &energy, std::vector<double> &eff, std::vector<double> &dEff);	///< Efficiency at every accepted peak that matches a peak from the literature
+bool readRunList(const char *path, std::vector<calibConfig> &runs, const char *suffix = "_calibration.json");	///< Reads the list of runs for the batch and array modes
+void parallelFor(unsigned int n, unsigned int nThreads, const std::function<void(unsigned int)> &task);		///< Calls task(0) ... task(n-1) on nThreads threads
+int runBatch(const std::vector<calibConfig> &runs, unsigned int nThreads);				///< Calibrates all the runs on nThreads threads. Returns the number of failed runs
+int calibrateArray(const calibConfig &cfg, unsigned int nThreads, bool crystalsOnY = false);		///< Calibrates every crystal of a detector array on nThreads threads. Returns the number of failed crystals
+int batchMain(int argc, char *argv[]);									///< Entry point of the --batch and --array modes
+#endif
@@ -0,0 +1,50 @@
+////////////////////////////////////////////////
+//Author: Sophia Devinyak (s.devinyak@gmail.com , sdevinya@uwaterloo.ca)
+//Synthetic gamma spectra with known calibration, and the benchmark of the calibration stages that uses them
+
+
+
+#ifndef __benchmark_h__
+#define __benchmark_h__
+
+#include "spectrum.h"
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+/// How a synthetic spectrum of one calibration source is made. Every line of allEnergy/allYield with a non-zero yield gives
+///    - a gaussian photopeak with area yield * effFunc(E) per decay and the FWHM sqrt(noise^2 + (fwhm^2-noise^2)*E/1332),
+///    - a step under the peak like the bkg function (erfc with the width of the peak, stepRatio times the height of the peak),
+///    - a flat Compton continuum up to the Compton edge (smeared by the resolution), with (1-peakToTotal)/peakToTotal times the counts of the peak.
+/// A falling exponential room background is added, then every bin is drawn from a Poisson distribution.
+struct syntheticConfig
+{
+        int iso = 0;					///< Index of the source in allIsotopes.
+        unsigned int nBins = 16384;			///< Number of bins (detector channels) of the spectrum.
+        double eMax = 3000;				///< Energy of the last channel in keV; the gain is eMax/nBins keV per channel.
+        double offset = 2;				///< Energy of channel 0 in keV.
+        double counts = 1e7;				///< Expected total number of counts in the spectrum.
+        double fwhm = 1.8;				///< FWHM of the peaks at 1332 keV in keV.
+        double noise = 1.0;				///< FWHM of the peaks at 0 keV (electronic noise) in keV.
+        double peakToTotal = 0.25;			///< Fraction of the detected gamma rays of a line that are in its photopeak; the rest is Compton continuum.
+        double stepRatio = 0.005;			///< Height of the background step under a peak relative to the height of the peak.
+        double background = 0.05;			///< Fraction of the counts that are room background.
+        double backgroundScale = 400;			///< Slope of the room background exp(-E/backgroundScale) in keV.
+        std::vector<double> effPar{24.3,-0.9,0,-6.6,2,0};	///< Parameters of the effFunc that gives the true efficiency.
+        unsigned int seed = 4357;			///< Seed of the Poisson fluctuations.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// What the synthetic spectrum was made with, to compare the calibration with.
+struct syntheticTruth
+{
+        double m = 0;					///< Gain (E = m*ch + b).
+        double b = 0;					///< Offset.
+        double decays = 0;				///< Number of decays of the source (activity * run length).
+        std::vector<double> energy;			///< Energies of the lines in the spectrum in keV.
+        std::vector<double> area;			///< Expected area of the photopeak of every line.
+        std::vector<double> eff;			///< True efficiency at every line.
+};
+
+spectrumPtr syntheticSpectrum(const syntheticConfig &cfg, syntheticTruth &truth);	///< Makes a synthetic spectrum and describes what it was made with
+int benchmarkMain(int argc, char *argv[]);						///< Entry point of the --benchmark mode
+#endif
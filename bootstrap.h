@@ -0,0 +1,73 @@
+////////////////////////////////////////////////
+//Author: Sophia Devinyak (s.devinyak@gmail.com , sdevinya@uwaterloo.ca)
+//Monte Carlo (parametric bootstrap) uncertainty of the efficiency curve
+
+
+
+#ifndef __bootstrap_h__
+#define __bootstrap_h__
+
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+/// One point of the efficiency curve with everything that is resampled.
+struct efficiencyPoint
+{
+        double channel = 0;				///< Centroid of the peak in detector channels.
+        double dChannel = 0;				///< Uncertainty of the centroid.
+        double area = 0;				///< Area of the peak (# of gamma particles detected).
+        double dArea = 0;				///< Uncertainty of the area.
+        double energy = 0;				///< Energy of the matching peak from the literature in keV.
+        double yield = 0;				///< Yield of the peak from the literature.
+        double dYield = 0;				///< Uncertainty of the yield.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Everything the efficiency points depend on, with the uncertainties that are propagated.
+struct bootstrapInput
+{
+        std::vector<efficiencyPoint> points;		///< The points of the efficiency curve.
+        double activity = 0;				///< Activity of the source at the time of the calibration run in Bq.
+        double dact = 0;				///< Uncertainty of the activity.
+        double runLength = 0;				///< Length of the calibration run in seconds.
+        double dRunLength = 0;				///< Uncertainty of the run length.
+        double m = 0;					///< Slope of the channel->energy calibration (E = m*ch + b).
+        double b = 0;					///< Offset of the channel->energy calibration.
+        double dm = 0;					///< Uncertainty of the slope.
+        double db = 0;					///< Uncertainty of the offset.
+        double mbCov = 0;				///< Covariance of the slope and the offset.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Settings of the resampling.
+struct bootstrapConfig
+{
+        unsigned int nReplicas = 2000;			///< Number of resampled efficiency curves.
+        unsigned int nThreads = 1;			///< Number of threads that fit the replicas.
+        unsigned int seed = 4357;			///< Seed of the random numbers. Replica i (from 0) always uses the seed seed+i+1, so the result does not depend on the number of threads.
+        double eMin = 10;				///< Lowest energy of the confidence band in keV.
+        double eMax = 7000;				///< Highest energy of the confidence band in keV.
+        unsigned int nBand = 200;			///< Number of energies of the band (equally spaced in log(E)).
+        double level = 0.6827;				///< Confidence level of the band (0.6827 is +-1 sigma).
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Uncertainty of the efficiency curve from the replicas.
+struct efficiencyBand
+{
+        int nReplicas = 0;				///< Number of replicas that were fitted.
+        int nConverged = 0;				///< Number of replicas whose fit converged; only these are used.
+        std::vector<double> par;			///< Parameters of the fit of the points themselves.
+        std::vector<double> mean;			///< Mean of the parameters of the replicas.
+        std::vector<double> cov;			///< Covariance matrix of the parameters of the replicas (row by row).
+        std::vector<double> energy;			///< Energies of the band in keV.
+        std::vector<double> eff;			///< Efficiency of the fit of the points themselves at every energy.
+        std::vector<double> median;			///< Median efficiency of the replicas at every energy.
+        std::vector<double> low;			///< Lower edge of the band at every energy.
+        std::vector<double> high;			///< Upper edge of the band at every energy.
+        double covariance(unsigned int i, unsigned int j) const {return cov[i*mean.size()+j];}	///< Covariance of the parameters i and j.
+};
+
+bool bootstrapEfficiency(const bootstrapInput &input, const bootstrapConfig &cfg, efficiencyBand &band, std::string &error);	///< Resamples the efficiency points, refits every replica and returns the covariance and the confidence band
+#endif
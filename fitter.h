@@ -0,0 +1,60 @@
+////////////////////////////////////////////////
+//Author: Sophia Devinyak (s.devinyak@gmail.com , sdevinya@uwaterloo.ca)
+//Fitting of all the gamma peaks at once, in parallel
+
+
+
+#ifndef __fitter_h__
+#define __fitter_h__
+
+#include "spectrum.h"
+#include "telemetry.h"
+#include <Rtypes.h>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fit of one gamma peak with the gausbkg function. Everything is in detector channels.
+struct peakFit
+{
+        double height = 0;				///< Height of the gaussian (par[0] of gausbkg).
+        double center = 0;				///< Centroid of the gaussian (par[1]).
+        double sigma = 0;				///< Standard deviation of the gaussian (par[2]).
+        double base = 0;				///< Vertical shift of the background (par[3]).
+        double stepWidth = 0;				///< Horizontal stretch of the background step (par[4]).
+        double step = 0;				///< Vertical stretch of the background step (par[5]).
+        double dCenter = 0;				///< Uncertainty of the centroid.
+        double area = 0;				///< Area of the gaussian without the background (# of gamma particles in the peak).
+        double dArea = 0;				///< Uncertainty of the area from the fit.
+        double low = 0;					///< Lower limit of the fit.
+        double high = 0;				///< Upper limit of the fit.
+        double chi2 = 0;				///< Chi2 of the fit (of the whole multiplet if the peak was fitted together with other peaks).
+        int ndf = 0;					///< Number of degrees of freedom of the fit.
+        int status = -1;				///< Status of the minimizer, 0 if the fit converged.
+        int nCalls = 0;					///< Number of function calls of the minimizer.
+        double wall = 0;				///< Wall clock time of the fit in ms (of the whole multiplet if the peak was fitted together with other peaks).
+        int multiplet = 1;				///< Number of peaks (including the found peaks that were not identified) fitted together with this peak.
+        bool valid = false;				///< True if the fit converged and the centroid is inside the fit range.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fits all the gamma peaks of a spectrum up front, instead of one peak per click.
+/// Every region of interest is fitted by its own Minuit2 minimizer with the analytic gradient of gausbkg, so the regions can be fitted in parallel.
+/// Peaks whose regions overlap are fitted together as one multiplet (sum of gausbkg functions with one common background level).
+/// Found peaks that were not identified (setInterferers) but lie inside a region are added to the multiplet so that they don't bias the area.
+/// The tallest peaks are fitted first; the widths and background steps of the other peaks are started from what was found for them.
+class peakFitter
+{
+        private:
+        spectrumPtr spectrum;				///< The spectrum, shared with the other stages (not copied).
+        std::vector<double> interferers;		///< Found peaks that are not fitted for themselves.
+        std::vector<peakFit> fits;			///< Fit of every peak, in the order the peaks were given to fitAll().
+        std::vector<peakFit> previous;			///< Earlier fits of the same peaks, used as starting values (see setPrevious).
+        public:
+        peakFitter(spectrumPtr counts);						///< Class constructor: stores the spectrum to be fitted.
+        void setInterferers(const std::vector<double> &channels);			///< Found peaks that are not fitted for themselves, but must be included in the fit of the regions they are in.
+        void setPrevious(const std::vector<peakFit> &fits);				///< Earlier fits of the same peaks; they give the starting values of the fits.
+        void fitAll(const std::vector<double> &centers, const std::vector<double> &heights, double halfWindow, double sigma0, unsigned int nThreads);	///< Fits all the peaks in +-halfWindow windows.
+        const std::vector<peakFit> &results() const {return fits;}			///< Fits of all the peaks.
+        void record(telemetry &log) const;						///< Adds the convergence of every fit to the log.
+};
+#endif
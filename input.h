@@ -20,6 +20,9 @@
 #include <functional>
 #include <iostream>
 #include <fstream>
+#include <atomic>
+#include <string>
+#include <thread>
 
 #include <RQ_OBJECT.h>
 #include <TGClient.h>
@@ -31,6 +34,8 @@
 #include <TGNumberEntry.h>
 #include <TDatime.h>
 #include <TApplication.h>
+#include <TTimer.h>
+#include "bootstrap.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Creates a window with buttons and input fields to enter the information about the .root file with the gamma spectum of the calibration run.
@@ -73,8 +78,7 @@ class gammaSearch
         void redoSearch();					///< Deletes the previous gamma search results and does it over again using the new sensitivity value.
         void selectPeak();					///< Selects a gamma peak.
         void deletePeak();					///< Deletes the selected gamma peak.
-        void correlatePeaks();					///< Wrapper function for performing the correlation of the found gamma peaks to those from the literature.
-        void ratios();						///< This function performs the correlations between the found gamma peaks and those from the literature.
+        void correlatePeaks();					///< This function performs the correlation of the found gamma peaks to those from the literature.
 };
 ////////////////////////////////////////////////////////////////////////////////
 /// This class is for correlating the detector channels to energy levels and all related functions.
@@ -111,6 +115,7 @@ class gammaFits
         float area;						///< This value will contain the integral of the gamma peak fit
         float nrg;						///< This value will contain the centroid of the gamma peak fit
         unsigned int peak_index = 0;				///< This value will contain the index of the peak that's being fitted at the moment.
+        void showPeak();					///< Draws the fit of the current peak and updates the label.
         public:			
         gammaFits(const TGWindow *p, UInt_t w, UInt_t h);	///< Class constructor: constructs a window for gamma fits and fits the first gamma peak.
         virtual ~gammaFits();					///< Class destructor.
@@ -127,9 +132,16 @@ class efficiency
         TGMainFrame *fMain;					///< The main frame of the window.
         TRootEmbeddedCanvas *fEcanvas3;				///< The embedded canvas that will contain the efficiency curve.
         TCanvas *effi;						///< Alias for fEcanvas3. Needed because this canvas is going to be called outside of the constructor too.
+        TTimer *bandTimer;					///< Checks every 100 ms whether the uncertainty band is ready (its replicas are fitted in another thread so the window does not freeze).
+        std::thread bandWorker;					///< Thread that fits the replicas of the band of this window.
+        efficiencyBand band;					///< Uncertainty band of the efficiency curve, calculated in bandWorker.
+        std::string bandError;					///< Why the band could not be calculated.
+        bool bandOk = false;					///< True if the band was calculated.
+        std::atomic<bool> bandReady{false};			///< True when bandWorker is done.
         public:
         efficiency(const TGWindow *p, UInt_t w, UInt_t h);	///< Class constructor: constructs a window for efficiency curve.
         virtual ~efficiency();					///< Class destructor.
         void plot();						///< Plots and fits the efficiency curve.
+        void drawBand();					///< Draws the uncertainty band of the efficiency curve once it is ready.
 };
 #endif
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////
+//Author: Sophia Devinyak (s.devinyak@gmail.com , sdevinya@uwaterloo.ca)
+//Matching of the found gamma peaks to the gamma energies from the literature
+
+
+
+#ifndef __matcher_h__
+#define __matcher_h__
+
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+/// One found peak that was identified as a peak from the literature.
+struct peakMatch
+{
+        int peak;					///< Index of the found peak.
+        int isotope;					///< Index of the isotope in allIsotopes.
+        int line;					///< Index of the peak from the literature in allEnergy[isotope].
+        float channel;					///< Centroid of the found peak in detector channels.
+        float energy;					///< Energy of the peak from the literature in keV.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// The best channel->energy mapping found by the peakMatcher.
+struct matchResult
+{
+        double m = 0;					///< Slope of the mapping E = m*ch + b.
+        double b = 0;					///< Offset of the mapping.
+        double score = 0;				///< Score of the mapping: every identified peak adds up to 1, less the further it is from the literature energy.
+        int candidates = 0;				///< Number of different candidate mappings that were scored (by all the matchers in identifyIsotope).
+        int iso = -1;					///< Isotope with the most identified peaks.
+        std::vector<int> isotopes;			///< All the isotopes with enough identified peaks (more than one for a mixture of sources).
+        std::vector<peakMatch> matches;			///< The identified peaks, in the order of appearance along the x axis.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Correlates the found gamma peaks with the peaks from the literature without trying the found peaks one by one.
+/// The ratios of all pairs of peaks from the literature are sorted once. Then every pair of found peaks is looked up in that index (within 1%, like gammaSearch used to do),
+/// and every pair that matches gives a candidate linear mapping E = m*ch + b. Every candidate is tried only once and scored by how many found peaks land within the tolerance of a literature peak.
+/// Every literature peak can be assigned to one found peak only - if two found peaks land on the same literature peak, only the closer one is kept.
+class peakMatcher
+{
+        private:
+        struct line {float energy; int isotope; int index;};	///< A peak from the literature.
+        struct ratio {float value; int low; int high;};		///< Ratio of two peaks from the literature (indices into lines, low energy first).
+        std::vector<line> lines;				///< All the peaks from the literature, sorted by energy.
+        std::vector<ratio> ratios;				///< All the ratios of the peaks from the literature, sorted by value.
+        std::vector<int> nLines;				///< Number of peaks with a non-zero energy for every isotope.
+        double ratioTolerance;					///< Relative tolerance of the ratio test.
+        double energyTolerance;					///< Tolerance in keV for a found peak to be identified as a peak from the literature.
+        double score(const std::vector<float> &channels, double m, double b, std::vector<peakMatch> *matches) const;	///< Scores the mapping E = m*ch + b.
+        public:
+        peakMatcher(const std::vector<int> &isotopes, double ratioTol = 0.01, double energyTol = 2.3);	///< Class constructor: builds the index of the ratios of the peaks of these isotopes.
+        bool match(const std::vector<float> &channels, matchResult &result) const;			///< Finds the best mapping of the found peaks (sorted along the x axis). Returns false if no mapping was found.
+        double fraction(const matchResult &result, int isotope) const;					///< Fraction of the peaks of the isotope that were identified.
+};
+
+bool identifyIsotope(const std::vector<float> &channels, matchResult &result);	///< Finds which isotope (or mixture of isotopes) from allIsotopes is in the spectrum and maps its peaks.
+#endif
@@ -0,0 +1,69 @@
+////////////////////////////////////////////////
+//Author: Sophia Devinyak (s.devinyak@gmail.com , sdevinya@uwaterloo.ca)
+//Fitting functions evaluated for many bins at once, and the efficiency fit that uses them
+
+
+
+#ifndef __models_h__
+#define __models_h__
+
+#include <Rtypes.h>
+#include <Minuit2/Minuit2Minimizer.h>
+#include <iostream>
+#include <vector>
+
+// Same functions as gausbkg, bkg and effFunc (and the gradient of gausbkg), but for n values of x at once.
+// If ROOT was built with VecCore, ROOT::Double_v::Size bins are evaluated by every instruction.
+void gausbkgBatch(const Double_t *x, Double_t *out, unsigned int n, const Double_t *par);				///< out[i] = gausbkg(x[i],par)
+void gausbkgGradientBatch(const Double_t *x, Double_t *out, Double_t *grad, unsigned int n, const Double_t *par);	///< out[i] = gausbkg(x[i],par); grad[j*n+i] = d gausbkg(x[i]) / d par[j]
+void bkgBatch(const Double_t *x, Double_t *out, unsigned int n, const Double_t *par);					///< out[i] = bkg(x[i],par)
+void effFuncBatch(const Double_t *x, Double_t *out, unsigned int n, const Double_t *par);				///< out[i] = effFunc(x[i],par)
+bool checkModels(std::ostream &out, double tolerance = 1e-6);								///< Compares the batch functions with gausbkg, bkg and effFunc
+
+////////////////////////////////////////////////////////////////////////////////
+/// Chi2 of the effFunc and the efficiency points. The effFunc is evaluated for all the points with one call of effFuncBatch.
+/// The points are overwritten in place by setData(), so the vectors are only reallocated when there are more points than before.
+class effChi2 : public ROOT::Math::IMultiGenFunction
+{
+        private:
+        std::vector<double> x;				///< Energies of the points.
+        std::vector<double> y;				///< Efficiencies of the points.
+        std::vector<double> w;				///< 1/uncertainty^2 of the efficiencies.
+        mutable std::vector<double> model;		///< Buffer for the values of the effFunc.
+        double DoEval(const double *p) const override;
+        public:
+        void setData(const std::vector<double> &energy, const std::vector<double> &eff, const std::vector<double> &dEff);	///< Replaces the points.
+        unsigned int NDim() const override;
+        ROOT::Math::IMultiGenFunction *Clone() const override {return new effChi2(*this);}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fits the effFunc to the efficiency points, like efficiency::plot() does with TGraphErrors::Fit, but the chi2 is calculated for all the points at once with effFuncBatch.
+/// The minimizer and the chi2 (with its buffers) are members, so the same object can be used to refit many times (e.g. for the bootstrap) without reallocating them.
+/// The minimizer only keeps a reference to the chi2, which is why the chi2 has to live as long as the minimizer.
+/// The uncertainties of the energies are not used; they are much smaller than the uncertainties of the efficiencies.
+class efficiencyFitter
+{
+        private:
+        ROOT::Minuit2::Minuit2Minimizer minimizer;	///< The minimizer, reused by every fit.
+        effChi2 chi2Function;				///< The chi2 minimized by every fit; the minimizer refers to it.
+        std::vector<double> par;			///< Fitted parameters.
+        std::vector<double> dPar;			///< Uncertainties of the fitted parameters.
+        std::vector<double> cov;			///< Covariance matrix of the parameters (6x6, row by row).
+        double chi2Value = 0;				///< Chi2 of the last fit.
+        int ndfValue = 0;				///< Number of degrees of freedom of the last fit.
+        int statusValue = -1;				///< Status of the minimizer after the last fit, 0 if the fit converged.
+        int nCallsValue = 0;				///< Number of function calls of the last fit.
+        public:
+        static const unsigned int nPar = 6;		///< Number of parameters of the effFunc.
+        efficiencyFitter();				///< Class constructor: creates the minimizer.
+        bool fit(const std::vector<double> &energy, const std::vector<double> &eff, const std::vector<double> &dEff, const double *start = nullptr);	///< Fits the points. Starts from start, or from the same values as efficiency::plot(). Returns true if the fit converged.
+        const std::vector<double> &parameters() const {return par;}			///< Fitted parameters.
+        const std::vector<double> &errors() const {return dPar;}			///< Uncertainties of the fitted parameters.
+        double covariance(unsigned int i, unsigned int j) const {return cov[i*nPar+j];}	///< Covariance of the parameters i and j.
+        double chi2() const {return chi2Value;}						///< Chi2 of the last fit.
+        int ndf() const {return ndfValue;}						///< Number of degrees of freedom of the last fit.
+        int status() const {return statusValue;}					///< Status of the minimizer after the last fit.
+        int nCalls() const {return nCallsValue;}					///< Number of function calls of the last fit.
+};
+#endif
@@ -0,0 +1,107 @@
+////////////////////////////////////////////////
+//Author: Sophia Devinyak (s.devinyak@gmail.com , sdevinya@uwaterloo.ca)
+//Online calibration of a spectrum that keeps growing during the acquisition, and tracking of the gain drift
+
+
+
+#ifndef __online_h__
+#define __online_h__
+
+#include "batch.h"
+#include "fitter.h"
+#include "matcher.h"
+#include "models.h"
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+/// Settings of the online mode.
+struct onlineConfig
+{
+        calibConfig run;				///< The source and the calibration run, as in a line of the list of runs. The runLength is the time acquired before the online mode started.
+        double interval = 10;				///< Time in seconds between two reads of the source.
+        double increment = 1e5;				///< The gain and offset of the new counts are updated every time this many counts were added since the last update.
+        double statistics = 0.1;			///< The whole spectrum (areas, average calibration, efficiency curve) is fitted again when its counts grew by this fraction since its last fit.
+        double shapeChi2 = 3;				///< A region is searched again if chi2/ndf of the new counts against its previous shape is above this (e.g. a peak moved or appeared).
+        double regrowth = 1;				///< A region is also searched again when its counts grew by this fraction since it was last searched.
+        unsigned int nRegions = 64;			///< Number of regions the spectrum is cut into for the peak search.
+        unsigned int maxUpdates = 0;			///< Stop after this many updates, 0 to run until the source stops growing for timeout seconds.
+        double timeout = 0;				///< Stop if the source did not grow for this many seconds, 0 to never stop.
+        std::string drift;				///< Path of the comma separated table with one line per update (gain, offset and efficiency parameters).
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// One line of the drift table.
+struct driftPoint
+{
+        double time = 0;				///< Live time of the spectrum in seconds (see onlineCalibration::read).
+        double events = 0;				///< Total number of counts in the spectrum.
+        double m = 0;					///< Gain fitted to the counts acquired since the last update (E = m*ch + b).
+        double dm = 0;					///< Uncertainty of that gain.
+        double b = 0;					///< Offset fitted to the counts acquired since the last update.
+        double db = 0;					///< Uncertainty of that offset.
+        double mAll = 0;				///< Gain fitted to the whole spectrum.
+        double bAll = 0;				///< Offset fitted to the whole spectrum.
+        int nPeaks = 0;					///< Number of peaks from the literature that were fitted.
+        int nRegions = 0;				///< Number of regions that were searched again.
+        bool full = false;				///< True if the whole spectrum was fitted again (otherwise mAll, bAll and the efficiency are those of the last such update).
+        bool effUpdated = false;			///< True if the efficiency curve was fitted again.
+        double effChi2 = 0;				///< Chi2/NDF of the efficiency fit.
+        std::vector<double> effPar;			///< Parameters of the efficiency fit.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Keeps the calibration of a spectrum up to date while it is being acquired, instead of calibrating it from scratch after the run.
+/// The spectrum is read again every interval (only the new records of an event file, or the whole file if a ROOT file was rewritten). Every time increment counts were added:
+///    - only the regions of the spectrum whose shape changed (or that grew a lot) are searched again with TSpectrum, the peaks of the other regions are kept,
+///    - the found peaks are correlated with the peaks from the literature,
+///    - the peaks are fitted again in the counts acquired since the last update (current gain and offset), starting from their previous gausbkg parameters.
+/// The gain is thus followed with a fixed number of counts per point, however long the run is. When the whole spectrum also grew by the statistics fraction since its last fit,
+///    - its peaks are fitted again too, starting from their previous parameters (areas and average calibration),
+///    - and the efficiency curve is fitted again, starting from its previous parameters.
+/// Every update adds one line to the drift table.
+class onlineCalibration
+{
+        private:
+        onlineConfig cfg;				///< The settings.
+        calibResult res;				///< The current calibration of the whole spectrum.
+        std::vector<double> counts;			///< The spectrum as it was read last.
+        std::vector<double> updated;			///< The spectrum at the last update.
+        std::vector<double> searched;			///< Counts of every region when it was last searched.
+        std::vector<std::vector<float>> regionMean;	///< Found peaks of every region.
+        std::vector<std::vector<float>> regionHeight;	///< Heights of the found peaks of every region.
+        std::map<float,peakFit> previous;		///< Last fit of every peak from the literature in the whole spectrum, by energy.
+        std::map<float,peakFit> previousNew;		///< Last fit of every peak from the literature in the new counts, by energy.
+        std::vector<double> effStart;			///< Parameters of the last efficiency fit, the starting values of the next one.
+        efficiencyFitter effFitter;			///< Efficiency fit, reused by every update.
+        double low = 0;					///< Lower edge of the spectrum.
+        double width = 1;				///< Width of the bins.
+        double lastTotal = 0;				///< Counts at the last update (or attempt to update).
+        double lastFull = 0;				///< Counts at the last fit of the whole spectrum.
+        unsigned long long nRead = 0;			///< Records of the event file that were read.
+        time_t modified = 0;				///< Modification time of the ROOT file when it was read.
+        long long fileSize = 0;				///< Size of the source file when it was read.
+        double before = 0;				///< Time acquired before the first read (cfg.run.runLength), 0 after a reset.
+        double live = 0;				///< Time during which the source grew since the first read (or the last reset).
+        double lastRead = 0;				///< Time of the last successful read, 0 before the first one.
+        double readTotal = 0;				///< Counts of the spectrum at the last read.
+        double grown = 0;				///< Time when the source last grew.
+        std::ofstream drift;				///< The drift table.
+        void reset();					///< Forgets everything, e.g. when a new acquisition overwrote the source.
+        void writeDrift(const driftPoint &point);	///< Adds a line to the drift table.
+        bool read(std::string &error);			///< Reads the new counts of the source. Returns false if they cannot be read.
+        int searchRegions(spectrumPtr spectrum);	///< Searches the regions that changed again. Returns the number of searched regions.
+        bool fitNew(spectrumPtr spectrum, const std::vector<double> &channels, const std::vector<double> &heights, const std::vector<float> &energies, const std::vector<double> &others,
+                    std::map<float,peakFit> &last, std::vector<peakFit> &fits);	///< Fits the peaks starting from the last fits and stores the new ones.
+        public:
+        onlineCalibration(const onlineConfig &config);	///< Class constructor: opens the drift table.
+        bool update(driftPoint &point);			///< Updates the calibration if the source grew enough. Returns false if there was no update.
+        int run();					///< Reads the source every interval until it stops growing or maxUpdates were done.
+        const calibResult &result() const {return res;}	///< The current calibration of the whole spectrum.
+};
+
+int onlineMain(int argc, char *argv[]);			///< Entry point of the --online mode and of the --daq stand-in for a data acquisition
+#endif
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////
+//Author: Sophia Devinyak (s.devinyak@gmail.com , sdevinya@uwaterloo.ca)
+//Gamma spectrum shared by all the stages of the calibration, built from a histogram or directly from list-mode event data
+
+
+
+#ifndef __spectrum_h__
+#define __spectrum_h__
+
+#include <Rtypes.h>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TH1;
+class TH1F;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Contents of the bins of a gamma spectrum (in detector channels). The spectrum is never changed after it was built,
+/// so the peak search, the correlation and the peak fits (and all their threads) read the same counts through a spectrumPtr instead of cloning the histogram.
+class spectrumBuffer
+{
+        private:
+        std::vector<double> counts;			///< Content of every bin.
+        double xmin;					///< Lower edge of the first bin in channels.
+        double width;					///< Width of the bins in channels.
+        public:
+        spectrumBuffer(std::vector<double> &&binContents, double low, double binWidth);	///< Class constructor: bin i goes from low+i*binWidth to low+(i+1)*binWidth. Takes the contents over without copying them.
+        unsigned int size() const {return counts.size();}				///< Number of bins.
+        const std::vector<double> &contents() const {return counts;}			///< Contents of all the bins.
+        double content(unsigned int i) const {return counts[i];}			///< Content of bin i (0 is the first bin).
+        double low() const {return xmin;}						///< Lower edge of the first bin.
+        double high() const {return xmin+counts.size()*width;}			///< Upper edge of the last bin.
+        double binWidth() const {return width;}					///< Width of the bins.
+        double binCenter(unsigned int i) const {return xmin+(i+0.5)*width;}		///< Center of bin i.
+        int findBin(double x) const;							///< Bin that contains x, -1 if x is outside of the spectrum.
+        double total() const;								///< Sum of all the bins.
+        TH1F *histogram(const char *name, const char *title) const;			///< New histogram with the same bins, used only to draw the spectrum.
+};
+typedef std::shared_ptr<const spectrumBuffer> spectrumPtr;	///< The spectrum as it is passed between the stages.
+
+////////////////////////////////////////////////////////////////////////////////
+/// How the spectrum is built from list-mode event data (a TTree or a flat binary file of events).
+/// Every event value (detector channel) between low and high is added to one of the nBins bins, if the gate value of the event is between gateLow and gateHigh.
+struct ingestConfig
+{
+        unsigned int nBins = 16384;			///< Number of bins of the spectrum.
+        double low = 0;					///< Lower edge of the spectrum in channels.
+        double high = 16384;				///< Upper edge of the spectrum in channels.
+        std::string gateField;				///< Branch (TTree) or field (binary file) the gate is applied to. Empty means the event value itself (energy gate).
+        double gateLow = -std::numeric_limits<double>::infinity();	///< Events with a gate value below this are ignored.
+        double gateHigh = std::numeric_limits<double>::infinity();	///< Events with a gate value above this are ignored.
+        unsigned int nThreads = 1;			///< Number of threads that fill partial spectra, which are then added together.
+        unsigned long long chunkSize = 1ULL<<24;	///< Size in bytes of the pieces of a binary file given to the threads.
+};
+
+bool parseIngestOption(const std::string &option, ingestConfig &cfg);	///< Reads one key=value option (bins, range, gate, gatefield, threads, chunk). Returns false if it is not an ingest option.
+spectrumPtr spectrumFromHistogram(const TH1 *hist);									///< Copies the bins of a histogram
+spectrumPtr spectrumFromTree(const std::string &file, const std::string &tree, const std::string &branch, const ingestConfig &cfg, std::string &error);	///< Fills the spectrum from a branch of a TTree
+spectrumPtr spectrumFromEvents(const std::string &file, const std::string &format, const ingestConfig &cfg, std::string &error);			///< Fills the spectrum from a flat binary file of events
+bool addEvents(const std::string &file, const std::string &format, const ingestConfig &cfg, std::vector<double> &counts, unsigned long long &nRead, std::string &error);		///< Adds the records of a binary event file after the first nRead to counts
+spectrumPtr loadSpectrum(const std::string &file, const std::string &canvas, const std::string &histogram, const ingestConfig &cfg, std::string &error);	///< Reads the spectrum described by the file, canvas and histogram fields of the File Input window
+int searchSpectrum(const spectrumBuffer &spectrum, double sensitivity, std::vector<float> &mean, std::vector<float> &height);	///< TSpectrum peak search, peaks sorted along the x axis
+int searchSpectrumRange(const spectrumBuffer &spectrum, int first, int last, double sensitivity, std::vector<float> &mean, std::vector<float> &height);	///< Same search, only in the bins first ... last
+#endif
@@ -0,0 +1,99 @@
+////////////////////////////////////////////////
+//Author: Sophia Devinyak (s.devinyak@gmail.com , sdevinya@uwaterloo.ca)
+//Timing of the calibration stages and convergence of the fits, written to a log that can be collected over many runs
+
+
+
+#ifndef __telemetry_h__
+#define __telemetry_h__
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+/// One stage of a calibration (loading the spectrum, peak search, correlation, peak fits, efficiency fit, ...).
+struct stageRecord
+{
+        std::string stage;				///< Name of the stage.
+        double wall = 0;				///< Wall clock time in ms.
+        double cpu = 0;					///< CPU time in ms of the thread that ran the stage and of the parallelFor workers it started (see threadCpuTime).
+        int items = 0;					///< What the stage produced: found peaks, scored correlation candidates, fitted peaks, ...
+        bool ok = true;					///< False if the stage failed.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// One fit done by Minuit2.
+struct fitRecord
+{
+        std::string stage;				///< Stage the fit belongs to (peak or efficiency).
+        double x = 0;					///< Centroid of the peak in channels (0 for the efficiency fit).
+        double wall = 0;				///< Wall clock time of the fit in ms (of the whole multiplet for peaks fitted together).
+        int status = -1;				///< Status of the minimizer, 0 if the fit converged.
+        int nCalls = 0;					///< Number of function calls of the minimizer.
+        double chi2 = 0;				///< Chi2 of the fit.
+        int ndf = 0;					///< Number of degrees of freedom.
+        int multiplet = 1;				///< Number of peaks fitted together.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Everything that is recorded about one calibration run: the time of every stage, every fit, and counters (allocations of ROOT objects, retries of the GUI steps, ...).
+/// Recording only stores a few numbers, so it is always on; the records are written only if a log file is given.
+/// The log is appended to, so the records of many runs (and many processes) end up in one file:
+///    - .csv: one line per stage, fit or counter, with the name of the run in the first column,
+///    - anything else: one JSON object per run and per line (JSON Lines).
+/// All the functions can be called from several threads at the same time.
+class telemetry
+{
+        private:
+        std::string run;				///< Name of the run (usually the file of the spectrum).
+        std::vector<stageRecord> stages;		///< All the stages, in the order they ended.
+        std::vector<fitRecord> fits;			///< All the fits.
+        std::map<std::string,int> counters;		///< Counters by name.
+        mutable std::mutex lock;			///< Protects all of the above.
+        public:
+        telemetry(const std::string &runName = "") : run(runName) {}	///< Class constructor: an empty log for the run.
+        void setRun(const std::string &runName);	///< Names the run.
+        void clear();					///< Forgets all the records, e.g. when the GUI starts a new calibration.
+        void addStage(const stageRecord &record);	///< Records a stage.
+        void addFit(const fitRecord &record);		///< Records a fit.
+        void count(const std::string &name, int n = 1);	///< Adds n to a counter.
+        std::vector<stageRecord> stageRecords() const;	///< Copy of the stages that were recorded.
+        bool write(const std::string &path) const;	///< Appends the records to the log file. Returns false if it cannot be written.
+        static telemetry &global();			///< The log of the GUI, which has one calibration at a time.
+};
+
+double threadCpuTime();				///< CPU time in ms of the calling thread and of the parallelFor workers it started
+void addWorkerCpuTime(double ms);		///< Adds the CPU time of a finished worker to the thread that started it
+std::string quotedText(const std::string &s, char escape);		///< The text as a JSON string (escape \) or a quoted CSV field (escape ")
+std::string numberText(double x, bool csv, int precision = 8);	///< A number as text, null in JSON or empty in CSV if it is nan or inf
+
+////////////////////////////////////////////////////////////////////////////////
+/// Measures the wall and CPU time of a stage from its construction to its destruction (or to stop()) and records it.
+class stageTimer
+{
+        private:
+        telemetry &log;					///< Where the stage is recorded.
+        stageRecord record;				///< The stage.
+        std::chrono::steady_clock::time_point start;	///< Wall clock at the start.
+        double cpuStart;				///< CPU time of the thread at the start (see threadCpuTime).
+        bool stopped = false;				///< True once the stage was recorded.
+        public:
+        stageTimer(telemetry &target, const std::string &stage);	///< Starts timing the stage.
+        ~stageTimer() {stop();}				///< Records the stage if stop() was not called.
+        void setItems(int n) {record.items = n;}	///< What the stage produced.
+        bool result(bool ok) {record.ok = ok; return ok;}	///< Sets whether the stage succeeded and returns ok.
+        void stop();					///< Records the stage now.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Allocates a ROOT object with new, and counts the allocations of its class in the log of the GUI.
+template <class T, class... Args> T *tracked(Args &&...args)
+{
+	telemetry::global().count(std::string("new ")+T::Class_Name());
+	return new T(std::forward<Args>(args)...);
+}
+#endif